@@ -0,0 +1,65 @@
+import argparse
+import json
+import sys
+
+# Compare two hdf5bench JSON result files and flag cases whose throughput dropped
+# or whose memory use grew by more than the threshold.
+#
+#   python3 compare.py baseline.json candidate.json --threshold 0.10
+
+CASE_KEYS = ("schema", "records", "batch", "layout", "filter")
+HIGHER_IS_BETTER = ("writeMiBPerSecond", "readMiBPerSecond")
+LOWER_IS_BETTER = ("peakRssKiB", "writeAllocations", "readAllocations")
+# Run parameters that change what is measured; results are only comparable when these match
+RUN_PARAMETERS = ("chunkRows", "repeat", "hdf5Version")
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data, {tuple(r[k] for k in CASE_KEYS): r for r in data["results"]}
+
+
+parser = argparse.ArgumentParser(description="Compare two hdf5bench result files")
+parser.add_argument("baseline")
+parser.add_argument("candidate")
+parser.add_argument("--threshold", type=float, default=0.10,
+                    help="relative change treated as a regression (default: 0.10)")
+parser.add_argument("--allow-mismatch", action="store_true",
+                    help="compare even when chunkRows, repeat or hdf5Version differ")
+args = parser.parse_args()
+
+base_info, base = load(args.baseline)
+cand_info, cand = load(args.candidate)
+print(f"baseline {base_info['revision']} ({base_info['timestamp']}) vs "
+      f"candidate {cand_info['revision']} ({cand_info['timestamp']})\n")
+
+mismatched = [p for p in RUN_PARAMETERS if base_info.get(p) != cand_info.get(p)]
+for p in mismatched:
+    print(f"{'warning' if args.allow_mismatch else 'error'}: {p} differs: "
+          f"{base_info.get(p)} vs {cand_info.get(p)}")
+if mismatched:
+    if not args.allow_mismatch:
+        print("runs are not comparable; rerun with matching parameters or pass --allow-mismatch")
+        sys.exit(2)
+    print()
+
+regressions = 0
+for key in sorted(base.keys() & cand.keys(), key=str):
+    changes = []
+    for metric in HIGHER_IS_BETTER + LOWER_IS_BETTER:
+        old, new = base[key][metric], cand[key][metric]
+        if old == 0:
+            continue
+        change = (new - old) / old
+        worse = change < -args.threshold if metric in HIGHER_IS_BETTER else change > args.threshold
+        if worse:
+            regressions += 1
+        changes.append(f"{metric} {change:+.1%}{' !' if worse else ''}")
+    print(" ".join(str(k) for k in key).ljust(50), ", ".join(changes))
+
+for key in sorted(base.keys() ^ cand.keys(), key=str):
+    print(" ".join(str(k) for k in key).ljust(50), "only in", "baseline" if key in base else "candidate")
+
+print(f"\n{regressions} regression(s) beyond {args.threshold:.0%}")
+sys.exit(1 if regressions else 0)
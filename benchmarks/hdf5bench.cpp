@@ -0,0 +1,760 @@
+#include "common_cpp.h"
+#include "bench_revision.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+
+const H5std_string BENCH_FILE_NAME("hdf5bench_scratch.h5");
+const H5std_string BENCH_DATASET_NAME("bench");
+
+// Count heap allocations so each case can report how many it made. On glibc the whole malloc family
+// (malloc, calloc, realloc, memalign, posix_memalign, aligned_alloc, valloc, pvalloc) is interposed,
+// which also catches allocations made inside the HDF5 shared libraries and every operator new,
+// aligned or not. Memory mapped directly with mmap is not counted. Other platforms report zero.
+static std::atomic<size_t> allocationCount{0};
+static std::atomic<size_t> allocationBytes{0};
+
+#ifdef __GLIBC__
+static void countAllocation(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+static bool isPowerOfTwo(size_t n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void* __libc_valloc(size_t size);
+void* __libc_pvalloc(size_t size);
+
+void* malloc(size_t size) {
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, size_t size) {
+    countAllocation(size);
+    return __libc_realloc(p, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** p, size_t alignment, size_t size) {
+    if (!isPowerOfTwo(alignment) || alignment % sizeof(void*) != 0) {
+        return EINVAL;
+    }
+    countAllocation(size);
+    void* result = __libc_memalign(alignment, size);
+    if (!result) {
+        return ENOMEM;
+    }
+    *p = result;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    if (!isPowerOfTwo(alignment)) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* valloc(size_t size) {
+    countAllocation(size);
+    return __libc_valloc(size);
+}
+
+void* pvalloc(size_t size) {
+    countAllocation(size);
+    return __libc_pvalloc(size);
+}
+}
+#endif
+
+// Schema from floatexamples/monitoring.cpp
+struct EnvData {
+    char site_name[20];
+    float aqi;
+    double temp;
+    int sample_count;
+};
+
+// Schema from compoundexamples/compound.py, packed to its 56-byte on-disk layout
+#pragma pack(push, 1)
+struct Demand {
+    uint64_t shipmentId;
+    char origCountry[2];
+    char origSlic[5];
+    char origSort[1];
+    char destCountry[2];
+    char destSlic[5];
+    char destIbi[1];
+    char destPostalCode[9];
+    char shipper[10];
+    char service[1];
+    char packageType[1];
+    char accessorials[1];
+    uint16_t pieces;
+    uint16_t weight;
+    uint32_t cube;
+    char committedTnt[1];
+    char committedDate[1];
+};
+#pragma pack(pop)
+static_assert(sizeof(Demand) == 56, "Demand must match the 56-byte struct in compound.py");
+
+const hsize_t WEATHER_COLUMNS = 17;
+
+// Source records for one case; strings backs the variable-length members of Record
+struct RecordBuffer {
+    std::vector<unsigned char> bytes;
+    std::vector<std::string> strings;
+};
+
+// A dataset schema: its HDF5 type, how many columns each record spans (0 for 1-D datasets),
+// and how to generate records in memory
+struct Schema {
+    std::string name;
+    std::function<DataType()> createType;
+    size_t recordSize;
+    hsize_t columns;
+    bool variableLength;
+    std::function<void(RecordBuffer&, size_t)> generate;
+};
+
+struct Options {
+    std::vector<std::string> schemas;
+    std::vector<hsize_t> records = {10000};
+    std::vector<hsize_t> batches = {0, 1000};
+    std::vector<std::string> layouts = {"contiguous", "chunked"};
+    std::vector<std::string> filters = {"none", "deflate"};
+    hsize_t chunkRows = 1024;
+    int repeat = 3;
+    std::string label = BENCH_GIT_REVISION;
+    std::string outPath = "hdf5bench.json";
+};
+
+struct Measurement {
+    double seconds = 0.0;
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+};
+
+struct Result {
+    std::string schema;
+    hsize_t records;
+    hsize_t batch;
+    std::string layout;
+    std::string filter;
+    size_t bytes;
+    size_t fileBytes;
+    Measurement write;
+    Measurement read;
+    long peakRssKiB;
+};
+
+CompType createEnvDataType() {
+    CompType datatype(sizeof(EnvData));
+    datatype.insertMember("siteName", HOFFSET(EnvData, site_name), StrType(PredType::C_S1, 20));
+    datatype.insertMember("airQualityIndex", HOFFSET(EnvData, aqi), PredType::NATIVE_FLOAT);
+    datatype.insertMember("temperature", HOFFSET(EnvData, temp), PredType::NATIVE_DOUBLE);
+    datatype.insertMember("sampleCount", HOFFSET(EnvData, sample_count), PredType::NATIVE_INT);
+    return datatype;
+}
+
+CompType createDemandType() {
+    auto fixedStr = [](size_t size) {
+        StrType type(PredType::C_S1, size);
+        type.setStrpad(H5T_STR_NULLPAD);
+        return type;
+    };
+    CompType datatype(sizeof(Demand));
+    datatype.insertMember("shipmentId", HOFFSET(Demand, shipmentId), PredType::STD_U64LE);
+    datatype.insertMember("origCountry", HOFFSET(Demand, origCountry), fixedStr(2));
+    datatype.insertMember("origSlic", HOFFSET(Demand, origSlic), fixedStr(5));
+    datatype.insertMember("origSort", HOFFSET(Demand, origSort), fixedStr(1));
+    datatype.insertMember("destCountry", HOFFSET(Demand, destCountry), fixedStr(2));
+    datatype.insertMember("destSlic", HOFFSET(Demand, destSlic), fixedStr(5));
+    datatype.insertMember("destIbi", HOFFSET(Demand, destIbi), fixedStr(1));
+    datatype.insertMember("destPostalCode", HOFFSET(Demand, destPostalCode), fixedStr(9));
+    datatype.insertMember("shipper", HOFFSET(Demand, shipper), fixedStr(10));
+    datatype.insertMember("service", HOFFSET(Demand, service), fixedStr(1));
+    datatype.insertMember("packageType", HOFFSET(Demand, packageType), fixedStr(1));
+    datatype.insertMember("accessorials", HOFFSET(Demand, accessorials), fixedStr(1));
+    datatype.insertMember("pieces", HOFFSET(Demand, pieces), PredType::STD_U16LE);
+    datatype.insertMember("weight", HOFFSET(Demand, weight), PredType::STD_U16LE);
+    datatype.insertMember("cube", HOFFSET(Demand, cube), PredType::STD_U32LE);
+    datatype.insertMember("committedTnt", HOFFSET(Demand, committedTnt), fixedStr(1));
+    datatype.insertMember("committedDate", HOFFSET(Demand, committedDate), fixedStr(1));
+    return datatype;
+}
+
+IntType createWeatherType() {
+    // Same fixed-point layout as bigdecimalmatrix/weatherdata.cpp
+    IntType fixedType(PredType::NATIVE_UINT32);
+    fixedType.setPrecision(25);
+    fixedType.setOffset(7);
+    fixedType.setOrder(H5T_ORDER_LE);
+    fixedType.setPad(H5T_PAD_ZERO, H5T_PAD_ZERO);
+    return fixedType;
+}
+
+StrType createStringType(size_t size, H5T_cset_t cset, H5T_str_t pad) {
+    StrType datatype(PredType::C_S1, size);
+    datatype.setCset(cset);
+    datatype.setStrpad(pad);
+    return datatype;
+}
+
+// Copy a string into a fixed-size field without a terminator, as the Demand fields are stored
+void copyField(char* dst, size_t size, const char* src) {
+    std::memset(dst, 0, size);
+    std::memcpy(dst, src, std::min(size, std::strlen(src)));
+}
+
+std::vector<Schema> createSchemas() {
+    std::vector<Schema> schemas;
+
+    schemas.push_back({"record", [] { return DataType(createCompoundType()); }, sizeof(Record), 0, true,
+                       [](RecordBuffer& buffer, size_t n) {
+        buffer.strings.resize(n);
+        Record* records = reinterpret_cast<Record*>(buffer.bytes.data());
+        for (size_t i = 0; i < n; ++i) {
+            Record& r = records[i];
+            r.recordId = 1000 + i;
+            std::strcpy(r.fixedStr, "FixedData");
+            buffer.strings[i] = "varData:" + std::to_string(i % 1900 + 1);
+            r.varStr.len = buffer.strings[i].size();
+            r.varStr.p = const_cast<char*>(buffer.strings[i].c_str());
+            r.floatVal = 3.14f;
+            r.doubleVal = 2.718;
+            r.int8_Val = static_cast<int8_t>(i);
+            r.uint8_Val = static_cast<uint8_t>(i);
+            r.int16_Val = static_cast<int16_t>(i);
+            r.uint16_Val = static_cast<uint16_t>(i);
+            r.int32_Val = static_cast<int32_t>(i);
+            r.uint32_Val = static_cast<uint32_t>(i);
+            r.int64_Val = static_cast<int64_t>(i);
+            r.uint64_Val = i;
+            r.bitfieldVal = (((i + 1ULL) << 7) | ((i % 4) * 32)) & 0x01FFFFFFFFFFFFFFULL;
+        }
+    }});
+
+    schemas.push_back({"envdata", [] { return DataType(createEnvDataType()); }, sizeof(EnvData), 0, false,
+                       [](RecordBuffer& buffer, size_t n) {
+        EnvData* records = reinterpret_cast<EnvData*>(buffer.bytes.data());
+        for (size_t i = 0; i < n; ++i) {
+            std::snprintf(records[i].site_name, sizeof(records[i].site_name), "Station %c",
+                          static_cast<char>('A' + i % 5));
+            records[i].aqi = static_cast<float>(i % 300) + 0.5f;
+            records[i].temp = static_cast<double>(i % 60) - 20.25;
+            records[i].sample_count = static_cast<int>(i % 40) - 8;
+        }
+    }});
+
+    schemas.push_back({"weather", [] { return DataType(createWeatherType()); },
+                       WEATHER_COLUMNS * sizeof(uint32_t), WEATHER_COLUMNS, false,
+                       [](RecordBuffer& buffer, size_t n) {
+        uint32_t* values = reinterpret_cast<uint32_t*>(buffer.bytes.data());
+        for (size_t i = 0; i < n * WEATHER_COLUMNS; ++i) {
+            values[i] = static_cast<uint32_t>((20.0 + static_cast<double>(i % 6400) / 64.0) * 128.0 + 0.5);
+        }
+    }});
+
+    schemas.push_back({"int64vector", [] { return DataType(PredType::NATIVE_INT64); }, sizeof(int64_t), 0, false,
+                       [](RecordBuffer& buffer, size_t n) {
+        int64_t* values = reinterpret_cast<int64_t*>(buffer.bytes.data());
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = 10 + static_cast<int64_t>(i % 41);
+        }
+    }});
+
+    schemas.push_back({"ascii", [] { return DataType(createStringType(8, H5T_CSET_ASCII, H5T_STR_SPACEPAD)); },
+                       8, 0, false, [](RecordBuffer& buffer, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::string label = "label " + std::to_string(i % 100 + 1);
+            label.resize(8, ' ');
+            std::memcpy(&buffer.bytes[i * 8], label.data(), 8);
+        }
+    }});
+
+    schemas.push_back({"utf8", [] { return DataType(createStringType(12, H5T_CSET_UTF8, H5T_STR_NULLTERM)); },
+                       12, 0, false, [](RecordBuffer& buffer, size_t n) {
+        const std::string javaneseTanda = u8"\uA9A0\uA9A4\uA9C0";
+        for (size_t i = 0; i < n; ++i) {
+            std::string label = javaneseTanda + " " + std::to_string(i % 10 + 1);
+            label.resize(12, '\0');
+            std::memcpy(&buffer.bytes[i * 12], label.data(), 12);
+        }
+    }});
+
+    schemas.push_back({"demand", [] { return DataType(createDemandType()); }, sizeof(Demand), 0, false,
+                       [](RecordBuffer& buffer, size_t n) {
+        Demand* records = reinterpret_cast<Demand*>(buffer.bytes.data());
+        for (size_t i = 0; i < n; ++i) {
+            Demand& d = records[i];
+            d.shipmentId = 1000 + i;
+            copyField(d.origCountry, sizeof(d.origCountry), "US");
+            copyField(d.origSlic, sizeof(d.origSlic), "12345");
+            copyField(d.origSort, sizeof(d.origSort), "L");
+            copyField(d.destCountry, sizeof(d.destCountry), "CA");
+            copyField(d.destSlic, sizeof(d.destSlic), "67890");
+            copyField(d.destIbi, sizeof(d.destIbi), "N");
+            copyField(d.destPostalCode, sizeof(d.destPostalCode), "A1B2C3");
+            copyField(d.shipper, sizeof(d.shipper), "FedEx");
+            copyField(d.service, sizeof(d.service), "E");
+            copyField(d.packageType, sizeof(d.packageType), "B");
+            copyField(d.accessorials, sizeof(d.accessorials), "N");
+            d.pieces = 2;
+            d.weight = 50;
+            d.cube = 1200;
+            copyField(d.committedTnt, sizeof(d.committedTnt), "Y");
+            copyField(d.committedDate, sizeof(d.committedDate), "D");
+        }
+    }});
+
+    return schemas;
+}
+
+// Reset the kernel's high-water mark so peak RSS is reported per case rather than per process.
+// Only Linux supports this; elsewhere the figure is the process-wide peak so far. Freed heap is
+// returned to the OS first so earlier cases do not inflate the baseline.
+void resetPeakRss() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs) {
+        clearRefs << "5";
+    }
+}
+
+// Peak RSS from /proc on Linux, getrusage on other POSIX systems; platforms with neither report zero
+long peakRssKiB() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+#if defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+#elif defined(__unix__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+DSetCreatPropList createPlist(const Schema& schema, const std::string& layout, const std::string& filter,
+                              hsize_t records, hsize_t chunkRows) {
+    DSetCreatPropList plist;
+    if (layout == "chunked") {
+        hsize_t chunk[2] = {std::max<hsize_t>(1, std::min(chunkRows, records)), schema.columns};
+        plist.setChunk(schema.columns ? 2 : 1, chunk);
+        if (filter == "shuffle+deflate") {
+            plist.setShuffle();
+        }
+        if (filter == "deflate" || filter == "shuffle+deflate") {
+            plist.setDeflate(6);
+        }
+    }
+    return plist;
+}
+
+// Run fn and record its wall time and the heap allocations made while it ran
+Measurement measure(const std::function<void()>& fn) {
+    Measurement m;
+    size_t countBefore = allocationCount.load();
+    size_t bytesBefore = allocationBytes.load();
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    m.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m.allocations = allocationCount.load() - countBefore;
+    m.allocatedBytes = allocationBytes.load() - bytesBefore;
+    return m;
+}
+
+// Select rows [offset, offset + count) of a 1-D or 2-D dataset
+DataSpace selectRows(DataSpace& fileSpace, const Schema& schema, hsize_t offset, hsize_t count) {
+    int rank = schema.columns ? 2 : 1;
+    hsize_t start[2] = {offset, 0};
+    hsize_t extent[2] = {count, schema.columns};
+    fileSpace.selectHyperslab(H5S_SELECT_SET, extent, start);
+    return DataSpace(rank, extent);
+}
+
+void writeDataset(const Schema& schema, const DataType& dataType, const DSetCreatPropList& plist,
+                  const RecordBuffer& source, hsize_t records, hsize_t batch) {
+    H5File file(BENCH_FILE_NAME, H5F_ACC_TRUNC);
+    hsize_t dims[2] = {records, schema.columns};
+    DataSpace fileSpace(schema.columns ? 2 : 1, dims);
+    DataSet dataset = file.createDataSet(BENCH_DATASET_NAME, dataType, fileSpace, plist);
+    for (hsize_t offset = 0; offset < records; offset += batch) {
+        hsize_t count = std::min(batch, records - offset);
+        DataSpace memSpace = selectRows(fileSpace, schema, offset, count);
+        dataset.write(&source.bytes[offset * schema.recordSize], dataType, memSpace, fileSpace);
+    }
+    dataset.close();
+    file.close();
+}
+
+void readDataset(const Schema& schema, const DataType& dataType, RecordBuffer& target,
+                 hsize_t records, hsize_t batch) {
+    H5File file(BENCH_FILE_NAME, H5F_ACC_RDONLY);
+    DataSet dataset = file.openDataSet(BENCH_DATASET_NAME);
+    DataSpace fileSpace = dataset.getSpace();
+    for (hsize_t offset = 0; offset < records; offset += batch) {
+        hsize_t count = std::min(batch, records - offset);
+        DataSpace memSpace = selectRows(fileSpace, schema, offset, count);
+        void* dst = &target.bytes[offset * schema.recordSize];
+        dataset.read(dst, dataType, memSpace, fileSpace);
+        if (schema.variableLength) {
+            H5Dvlen_reclaim(dataType.getId(), memSpace.getId(), H5P_DEFAULT, dst);
+        }
+    }
+}
+
+// Compare count records read back against the source. Record is the only variable-length schema:
+// its varStr member holds pointers, so the string contents are compared instead of the hvl_t itself.
+bool recordsMatch(const Schema& schema, const unsigned char* expected, const unsigned char* actual, size_t count) {
+    if (!schema.variableLength) {
+        return std::memcmp(expected, actual, count * schema.recordSize) == 0;
+    }
+    const size_t varStrBegin = offsetof(Record, varStr);
+    const size_t varStrEnd = varStrBegin + sizeof(hvl_t);
+    for (size_t i = 0; i < count; ++i) {
+        const Record* e = reinterpret_cast<const Record*>(expected + i * sizeof(Record));
+        const Record* a = reinterpret_cast<const Record*>(actual + i * sizeof(Record));
+        if (std::memcmp(e, a, varStrBegin) != 0 ||
+            std::memcmp(reinterpret_cast<const unsigned char*>(e) + varStrEnd,
+                        reinterpret_cast<const unsigned char*>(a) + varStrEnd, sizeof(Record) - varStrEnd) != 0 ||
+            e->varStr.len != a->varStr.len ||
+            std::memcmp(e->varStr.p, a->varStr.p, e->varStr.len) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read the dataset back in the same batches as the timed read and check it against the source,
+// so a wrong hyperslab or conversion fails the case instead of producing clean numbers
+void verifyDataset(const Schema& schema, const DataType& dataType, const RecordBuffer& source,
+                   hsize_t records, hsize_t batch) {
+    std::vector<unsigned char> actual(static_cast<size_t>(batch) * schema.recordSize);
+    H5File file(BENCH_FILE_NAME, H5F_ACC_RDONLY);
+    DataSet dataset = file.openDataSet(BENCH_DATASET_NAME);
+    DataSpace fileSpace = dataset.getSpace();
+    for (hsize_t offset = 0; offset < records; offset += batch) {
+        hsize_t count = std::min(batch, records - offset);
+        DataSpace memSpace = selectRows(fileSpace, schema, offset, count);
+        std::fill(actual.begin(), actual.end(), 0);
+        dataset.read(actual.data(), dataType, memSpace, fileSpace);
+        bool match = recordsMatch(schema, &source.bytes[offset * schema.recordSize], actual.data(),
+                                  static_cast<size_t>(count));
+        if (schema.variableLength) {
+            H5Dvlen_reclaim(dataType.getId(), memSpace.getId(), H5P_DEFAULT, actual.data());
+        }
+        if (!match) {
+            throw std::runtime_error(schema.name + ": records " + std::to_string(offset) + "-" +
+                                     std::to_string(offset + count - 1) + " read back differ from what was written");
+        }
+    }
+}
+
+Result runCase(const Schema& schema, hsize_t records, hsize_t batch, const std::string& layout,
+               const std::string& filter, const Options& options) {
+    resetPeakRss();
+    DataType dataType = schema.createType();
+    DSetCreatPropList plist = createPlist(schema, layout, filter, records, options.chunkRows);
+    hsize_t batchRows = batch ? batch : records;
+
+    RecordBuffer source;
+    source.bytes.resize(static_cast<size_t>(records) * schema.recordSize);
+    schema.generate(source, static_cast<size_t>(records));
+    RecordBuffer target;
+    target.bytes.resize(source.bytes.size());
+
+    Result result{schema.name, records, batch, layout, filter, source.bytes.size(), 0, {}, {}, 0};
+    for (int rep = 0; rep < options.repeat; ++rep) {
+        Measurement w = measure([&] { writeDataset(schema, dataType, plist, source, records, batchRows); });
+        Measurement r = measure([&] { readDataset(schema, dataType, target, records, batchRows); });
+        if (rep == 0) {
+            verifyDataset(schema, dataType, source, records, batchRows);
+        }
+        // Keep the best time, but allocations from the last (steady-state) repetition
+        result.write.seconds = rep == 0 ? w.seconds : std::min(result.write.seconds, w.seconds);
+        result.read.seconds = rep == 0 ? r.seconds : std::min(result.read.seconds, r.seconds);
+        result.write.allocations = w.allocations;
+        result.write.allocatedBytes = w.allocatedBytes;
+        result.read.allocations = r.allocations;
+        result.read.allocatedBytes = r.allocatedBytes;
+    }
+
+    std::ifstream scratch(BENCH_FILE_NAME, std::ios::binary | std::ios::ate);
+    result.fileBytes = static_cast<size_t>(scratch.tellg());
+    result.peakRssKiB = peakRssKiB();
+    return result;
+}
+
+template <typename T>
+std::vector<T> parseList(const std::string& value, const std::function<T(const std::string&)>& convert) {
+    std::vector<T> items;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        items.push_back(convert(item));
+    }
+    if (items.empty()) {
+        throw std::invalid_argument("Empty list '" + value + "'");
+    }
+    return items;
+}
+
+void printUsage() {
+    std::cout << "Usage: hdf5bench [options]\n"
+              << "  --schemas LIST   record,envdata,weather,int64vector,ascii,utf8,demand (default: all)\n"
+              << "  --records LIST   records per dataset (default: 10000)\n"
+              << "  --batch LIST     records per write/read call, 0 = whole dataset (default: 0,1000)\n"
+              << "  --layout LIST    contiguous,chunked (default: both)\n"
+              << "  --filter LIST    none,deflate,shuffle+deflate (default: none,deflate)\n"
+              << "  --chunk N        rows per chunk for the chunked layout (default: 1024)\n"
+              << "  --repeat N       repetitions per case, best time is kept (default: 3)\n"
+              << "  --label TEXT     revision label stored in the results (default: build commit)\n"
+              << "  --out FILE       JSON results file (default: hdf5bench.json)\n";
+}
+
+Options parseOptions(int argc, char* argv[], const std::vector<Schema>& schemas) {
+    Options options;
+    for (const Schema& schema : schemas) {
+        options.schemas.push_back(schema.name);
+    }
+    auto toString = [](const std::string& s) { return s; };
+    auto toCount = [](const std::string& s) { return static_cast<hsize_t>(std::stoull(s)); };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for " + arg);
+        }
+        std::string value = argv[++i];
+        if (arg == "--schemas") {
+            options.schemas = parseList<std::string>(value, toString);
+        } else if (arg == "--records") {
+            options.records = parseList<hsize_t>(value, toCount);
+        } else if (arg == "--batch") {
+            options.batches = parseList<hsize_t>(value, toCount);
+        } else if (arg == "--layout") {
+            options.layouts = parseList<std::string>(value, toString);
+        } else if (arg == "--filter") {
+            options.filters = parseList<std::string>(value, toString);
+        } else if (arg == "--chunk") {
+            options.chunkRows = std::max<hsize_t>(1, toCount(value));
+        } else if (arg == "--repeat") {
+            options.repeat = std::max(1, std::stoi(value));
+        } else if (arg == "--label") {
+            options.label = value;
+        } else if (arg == "--out") {
+            options.outPath = value;
+        } else {
+            throw std::invalid_argument("Unknown option " + arg);
+        }
+    }
+
+    for (const std::string& name : options.schemas) {
+        if (std::none_of(schemas.begin(), schemas.end(), [&](const Schema& s) { return s.name == name; })) {
+            throw std::invalid_argument("Unknown schema '" + name + "'");
+        }
+    }
+    for (const std::string& layout : options.layouts) {
+        if (layout != "contiguous" && layout != "chunked") {
+            throw std::invalid_argument("Unknown layout '" + layout + "'");
+        }
+    }
+    for (const std::string& filter : options.filters) {
+        if (filter != "none" && filter != "deflate" && filter != "shuffle+deflate") {
+            throw std::invalid_argument("Unknown filter '" + filter + "'");
+        }
+        if (filter != "none" && !H5Zfilter_avail(H5Z_FILTER_DEFLATE)) {
+            throw std::invalid_argument("This HDF5 build has no deflate filter");
+        }
+    }
+    for (hsize_t records : options.records) {
+        if (records == 0) {
+            throw std::invalid_argument("Record counts must be positive");
+        }
+    }
+    return options;
+}
+
+// Quote and escape a string for JSON output
+std::string jsonString(const std::string& value) {
+    std::ostringstream out;
+    out << '"';
+    for (unsigned char c : value) {
+        switch (c) {
+        case '"':  out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\b': out << "\\b"; break;
+        case '\f': out << "\\f"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (c < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                    << std::dec << std::setfill(' ');
+            } else {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+void writeJson(std::ostream& out, const Options& options, const std::vector<Result>& results) {
+    unsigned majnum, minnum, relnum;
+    H5get_libversion(&majnum, &minnum, &relnum);
+    char timestamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << std::setprecision(6);
+    out << "{\n"
+        << "  \"benchmark\": \"hdf5bench\",\n"
+        << "  \"revision\": " << jsonString(options.label) << ",\n"
+        << "  \"timestamp\": " << jsonString(timestamp) << ",\n"
+        << "  \"hdf5Version\": \"" << majnum << "." << minnum << "." << relnum << "\",\n"
+        << "  \"repeat\": " << options.repeat << ",\n"
+        << "  \"chunkRows\": " << options.chunkRows << ",\n"
+        << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        double megabytes = static_cast<double>(r.bytes) / (1024.0 * 1024.0);
+        out << (i ? "," : "") << "\n    {"
+            << "\"schema\": " << jsonString(r.schema) << ", "
+            << "\"records\": " << r.records << ", "
+            << "\"batch\": " << r.batch << ", "
+            << "\"layout\": " << jsonString(r.layout) << ", "
+            << "\"filter\": " << jsonString(r.filter) << ", "
+            << "\"bytes\": " << r.bytes << ", "
+            << "\"fileBytes\": " << r.fileBytes << ", "
+            << "\"writeSeconds\": " << r.write.seconds << ", "
+            << "\"writeMiBPerSecond\": " << megabytes / r.write.seconds << ", "
+            << "\"writeRecordsPerSecond\": " << static_cast<double>(r.records) / r.write.seconds << ", "
+            << "\"writeAllocations\": " << r.write.allocations << ", "
+            << "\"writeAllocatedBytes\": " << r.write.allocatedBytes << ", "
+            << "\"readSeconds\": " << r.read.seconds << ", "
+            << "\"readMiBPerSecond\": " << megabytes / r.read.seconds << ", "
+            << "\"readRecordsPerSecond\": " << static_cast<double>(r.records) / r.read.seconds << ", "
+            << "\"readAllocations\": " << r.read.allocations << ", "
+            << "\"readAllocatedBytes\": " << r.read.allocatedBytes << ", "
+            << "\"peakRssKiB\": " << r.peakRssKiB << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        std::vector<Schema> schemas = createSchemas();
+        Options options = parseOptions(argc, argv, schemas);
+
+        std::cout << std::left << std::setw(12) << "schema" << std::right << std::setw(10) << "records"
+                  << std::setw(8) << "batch" << "  " << std::left << std::setw(11) << "layout"
+                  << std::setw(16) << "filter" << std::right << std::setw(12) << "write MiB/s"
+                  << std::setw(12) << "read MiB/s" << std::setw(12) << "peak KiB" << "\n";
+
+        std::vector<Result> results;
+        for (const Schema& schema : schemas) {
+            if (std::find(options.schemas.begin(), options.schemas.end(), schema.name) == options.schemas.end()) {
+                continue;
+            }
+            for (hsize_t records : options.records) {
+                for (hsize_t batch : options.batches) {
+                    for (const std::string& layout : options.layouts) {
+                        for (const std::string& filter : options.filters) {
+                            // Filters only apply to chunked datasets
+                            if (layout == "contiguous" && filter != "none") {
+                                continue;
+                            }
+                            Result r = runCase(schema, records, batch, layout, filter, options);
+                            double megabytes = static_cast<double>(r.bytes) / (1024.0 * 1024.0);
+                            std::cout << std::left << std::setw(12) << r.schema << std::right
+                                      << std::setw(10) << r.records << std::setw(8) << r.batch << "  "
+                                      << std::left << std::setw(11) << r.layout << std::setw(16) << r.filter
+                                      << std::right << std::fixed << std::setprecision(1)
+                                      << std::setw(12) << megabytes / r.write.seconds
+                                      << std::setw(12) << megabytes / r.read.seconds
+                                      << std::setw(12) << r.peakRssKiB << "\n";
+                            results.push_back(r);
+                        }
+                    }
+                }
+            }
+        }
+        std::remove(BENCH_FILE_NAME.c_str());
+
+        std::ofstream out(options.outPath);
+        if (!out.is_open()) {
+            throw std::runtime_error("Could not open " + options.outPath);
+        }
+        writeJson(out, options, results);
+        std::cout << "\nResults for " << results.size() << " cases written to " << options.outPath << "\n";
+
+    } catch (H5::Exception& error) {
+        std::cerr << "HDF5 Exception: " << error.getDetailMsg() << std::endl;
+        return -1;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,27 @@
+# Writes bench_revision.h with the current `git describe --always --dirty`. Runs on every build
+# (see CMakeLists.txt) so results are stamped with the checked-out commit even when CMake does not
+# reconfigure. The header is only rewritten when the revision changes, so unchanged trees do not
+# rebuild hdf5bench.
+#
+#   cmake -DGIT_EXECUTABLE=git -DSOURCE_DIR=<repo> -DOUTPUT=<header> -P revision.cmake
+
+set(REVISION "unknown")
+if(GIT_EXECUTABLE)
+    execute_process(COMMAND ${GIT_EXECUTABLE} describe --always --dirty
+                    WORKING_DIRECTORY ${SOURCE_DIR}
+                    OUTPUT_VARIABLE GIT_REVISION
+                    OUTPUT_STRIP_TRAILING_WHITESPACE
+                    RESULT_VARIABLE GIT_RESULT
+                    ERROR_QUIET)
+    if(GIT_RESULT EQUAL 0 AND GIT_REVISION)
+        set(REVISION "${GIT_REVISION}")
+    endif()
+endif()
+
+set(CONTENT "#define BENCH_GIT_REVISION \"${REVISION}\"\n")
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} EXISTING)
+endif()
+if(NOT "${EXISTING}" STREQUAL "${CONTENT}")
+    file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
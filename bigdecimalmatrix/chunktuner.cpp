@@ -0,0 +1,509 @@
+#include <H5Cpp.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace H5;
+
+const H5std_string FILE_NAME("weather_data.h5");
+const H5std_string SCRATCH_FILE_NAME("chunktuner_scratch.h5");
+const H5std_string DATA_DATASET("Data");
+const H5std_string CACHE_BYTES_ATTRIBUTE("chunkCacheBytes");
+const H5std_string CACHE_SLOTS_ATTRIBUTE("chunkCacheSlots");
+
+// HDF5's built-in chunk cache: 1 MiB, 521 hash slots
+const size_t DEFAULT_CACHE_BYTES = 1024 * 1024;
+const size_t DEFAULT_CACHE_SLOTS = 521;
+const size_t MAX_CACHE_BYTES = 256 * 1024 * 1024;
+const size_t MAX_CACHED_CHUNKS = 10000;
+const size_t MIN_CHUNK_BYTES = 4 * 1024;
+const hsize_t MAX_CHUNK_COUNT = 65536;
+
+enum class ElementKind { Fixed32, UInt32, Int64, Float32, Float64 };
+
+// Access patterns a consumer can weight: a day's readings, one sensor over time, or the whole matrix
+enum Pattern { ROW = 0, COLUMN = 1, FULL = 2, PATTERN_COUNT = 3 };
+const char* PATTERN_NAMES[PATTERN_COUNT] = {"row", "col", "full"};
+
+struct Options {
+    hsize_t rows = 0;
+    hsize_t cols = 0;
+    ElementKind kind = ElementKind::Fixed32;
+    double weights[PATTERN_COUNT] = {1.0, 1.0, 0.0};
+    int samples = 64;
+    int repeat = 3;
+    std::string csvPath = "weatherdata.csv";
+};
+
+struct Candidate {
+    bool chunked;
+    hsize_t chunk[2];
+    size_t cacheBytes;
+    size_t cacheSlots;
+    double writeMs;
+    double accessUs[PATTERN_COUNT];
+    double score;
+};
+
+DataType createElementType(ElementKind kind) {
+    switch (kind) {
+    case ElementKind::Fixed32: {
+        // Same layout as weatherdata.cpp: 25 significant bits above 7 fractional bits
+        IntType fixedType(PredType::NATIVE_UINT32);
+        fixedType.setPrecision(25);
+        fixedType.setOffset(7);
+        fixedType.setOrder(H5T_ORDER_LE);
+        fixedType.setPad(H5T_PAD_ZERO, H5T_PAD_ZERO);
+        return fixedType;
+    }
+    case ElementKind::UInt32:
+        return DataType(PredType::NATIVE_UINT32);
+    case ElementKind::Int64:
+        return DataType(PredType::NATIVE_INT64);
+    case ElementKind::Float32:
+        return DataType(PredType::NATIVE_FLOAT);
+    case ElementKind::Float64:
+        return DataType(PredType::NATIVE_DOUBLE);
+    }
+    throw std::invalid_argument("Unknown element type");
+}
+
+size_t elementSize(ElementKind kind) {
+    return (kind == ElementKind::Int64 || kind == ElementKind::Float64) ? 8 : 4;
+}
+
+const char* elementName(ElementKind kind) {
+    switch (kind) {
+    case ElementKind::Fixed32: return "fixed32";
+    case ElementKind::UInt32:  return "uint32";
+    case ElementKind::Int64:   return "int64";
+    case ElementKind::Float32: return "float";
+    case ElementKind::Float64: return "double";
+    }
+    return "?";
+}
+
+ElementKind parseElementKind(const std::string& name) {
+    for (ElementKind kind : {ElementKind::Fixed32, ElementKind::UInt32, ElementKind::Int64,
+                             ElementKind::Float32, ElementKind::Float64}) {
+        if (name == elementName(kind)) {
+            return kind;
+        }
+    }
+    throw std::invalid_argument("Unknown element type '" + name + "'");
+}
+
+// Store a reading in the in-memory representation of the element type
+void encodeValue(double value, ElementKind kind, unsigned char* dst) {
+    switch (kind) {
+    case ElementKind::Fixed32: {
+        uint32_t v = static_cast<uint32_t>(value * 128.0 + 0.5);
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+    }
+    case ElementKind::UInt32: {
+        uint32_t v = static_cast<uint32_t>(value + 0.5);
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+    }
+    case ElementKind::Int64: {
+        int64_t v = static_cast<int64_t>(std::llround(value));
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+    }
+    case ElementKind::Float32: {
+        float v = static_cast<float>(value);
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+    }
+    case ElementKind::Float64:
+        std::memcpy(dst, &value, sizeof(value));
+        break;
+    }
+}
+
+std::vector<std::vector<double>> readCsv(const std::string& path) {
+    std::ifstream csvFile(path);
+    if (!csvFile.is_open()) {
+        throw std::runtime_error("Could not open " + path);
+    }
+
+    std::vector<std::vector<double>> data;
+    std::string line;
+    std::getline(csvFile, line); // Skip header
+    while (std::getline(csvFile, line)) {
+        std::stringstream ss(line);
+        std::string field;
+        std::vector<double> row;
+        while (std::getline(ss, field, ',')) {
+            row.push_back(std::stod(field));
+        }
+        if (!data.empty() && row.size() != data[0].size()) {
+            throw std::runtime_error("Ragged row in " + path);
+        }
+        data.push_back(row);
+    }
+    if (data.empty()) {
+        throw std::runtime_error("No data rows in " + path);
+    }
+    return data;
+}
+
+size_t nextPrime(size_t n) {
+    for (;; ++n) {
+        bool prime = n > 1;
+        for (size_t d = 2; d * d <= n && prime; ++d) {
+            prime = (n % d) != 0;
+        }
+        if (prime) {
+            return n;
+        }
+    }
+}
+
+hsize_t ceilDiv(hsize_t a, hsize_t b) {
+    return (a + b - 1) / b;
+}
+
+hsize_t clampDim(hsize_t value, hsize_t limit) {
+    return std::max<hsize_t>(1, std::min(value, limit));
+}
+
+// Sized cache: holds every chunk a single row or column read crosses. Returns false, leaving the
+// candidate untouched, when that fits in the default cache anyway.
+bool sizeCache(Candidate& candidate, hsize_t rows, hsize_t cols, size_t elemSize) {
+    size_t chunkBytes = static_cast<size_t>(candidate.chunk[0] * candidate.chunk[1]) * elemSize;
+    hsize_t chunksPerRow = ceilDiv(cols, candidate.chunk[1]);
+    hsize_t chunksPerColumn = ceilDiv(rows, candidate.chunk[0]);
+    size_t sizedBytes = std::min(MAX_CACHE_BYTES,
+                                 static_cast<size_t>(std::max(chunksPerRow, chunksPerColumn)) * chunkBytes);
+    if (sizedBytes <= DEFAULT_CACHE_BYTES) {
+        return false;
+    }
+    size_t cachedChunks = std::min<size_t>(sizedBytes / chunkBytes, MAX_CACHED_CHUNKS);
+    candidate.cacheBytes = sizedBytes;
+    candidate.cacheSlots = nextPrime(std::max<size_t>(DEFAULT_CACHE_SLOTS, 100 * cachedChunks));
+    return true;
+}
+
+// Chunk shapes worth trying for a rows x cols matrix: row bands, column bands and square tiles
+// at a small and a large chunk size, single-row chunks when a row is at least MIN_CHUNK_BYTES,
+// plus the existing contiguous layout. Shapes that split the matrix into more than
+// MAX_CHUNK_COUNT chunks are skipped: every chunk costs an index lookup on reads that cross it,
+// so they cannot win and would dominate the tuning time on tall matrices.
+std::vector<Candidate> buildCandidates(hsize_t rows, hsize_t cols, size_t elemSize) {
+    std::vector<std::pair<hsize_t, hsize_t>> shapes;
+    for (size_t targetBytes : {size_t(64 * 1024), size_t(1024 * 1024)}) {
+        hsize_t targetElems = std::max<hsize_t>(1, targetBytes / elemSize);
+        hsize_t side = static_cast<hsize_t>(std::sqrt(static_cast<double>(targetElems)));
+        shapes.push_back({clampDim(targetElems / cols, rows), cols});
+        shapes.push_back({clampDim(targetElems, rows), 1});
+        shapes.push_back({clampDim(side, rows), clampDim(side, cols)});
+    }
+    if (cols * elemSize >= MIN_CHUNK_BYTES) {
+        shapes.push_back({1, cols});
+    }
+
+    std::vector<Candidate> candidates;
+    candidates.push_back({false, {0, 0}, 0, 0, 0.0, {0.0, 0.0, 0.0}, 0.0});
+
+    std::vector<std::pair<hsize_t, hsize_t>> seen;
+    for (const auto& shape : shapes) {
+        if (std::find(seen.begin(), seen.end(), shape) != seen.end()) {
+            continue;
+        }
+        seen.push_back(shape);
+        if (ceilDiv(rows, shape.first) * ceilDiv(cols, shape.second) > MAX_CHUNK_COUNT) {
+            continue;
+        }
+
+        // No cache: chunks larger than the cache are read directly, touching only the selection
+        candidates.push_back({true, {shape.first, shape.second}, 0, DEFAULT_CACHE_SLOTS, 0.0, {0.0, 0.0, 0.0}, 0.0});
+        candidates.push_back({true, {shape.first, shape.second}, DEFAULT_CACHE_BYTES, DEFAULT_CACHE_SLOTS, 0.0, {0.0, 0.0, 0.0}, 0.0});
+
+        Candidate sized = {true, {shape.first, shape.second}, 0, 0, 0.0, {0.0, 0.0, 0.0}, 0.0};
+        if (sizeCache(sized, rows, cols, elemSize)) {
+            candidates.push_back(sized);
+        }
+    }
+    return candidates;
+}
+
+DSetCreatPropList createPlist(const Candidate& candidate) {
+    DSetCreatPropList plist;
+    if (candidate.chunked) {
+        plist.setChunk(2, candidate.chunk);
+    }
+    return plist;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void writeMatrix(const H5std_string& fileName, const DataType& dataType, const hsize_t dims[2],
+                 const Candidate& candidate, const std::vector<unsigned char>& buffer) {
+    H5File file(fileName, H5F_ACC_TRUNC);
+    DataSpace dataSpace(2, dims);
+    DataSet dataset = file.createDataSet(DATA_DATASET, dataType, dataSpace, createPlist(candidate));
+    dataset.write(buffer.data(), dataType);
+
+    if (candidate.chunked) {
+        // The chunk cache is an access property and is not stored in the file; record the tuned
+        // values so readers can pass them to DSetAccPropList::setChunkCache
+        DataSpace attrSpace(H5S_SCALAR);
+        uint64_t cacheBytes = candidate.cacheBytes;
+        uint64_t cacheSlots = candidate.cacheSlots;
+        dataset.createAttribute(CACHE_BYTES_ATTRIBUTE, PredType::NATIVE_UINT64, attrSpace)
+            .write(PredType::NATIVE_UINT64, &cacheBytes);
+        dataset.createAttribute(CACHE_SLOTS_ATTRIBUTE, PredType::NATIVE_UINT64, attrSpace)
+            .write(PredType::NATIVE_UINT64, &cacheSlots);
+    }
+}
+
+// Time one access pattern; the dataset is reopened each repetition so every pass starts with a cold chunk cache
+double measurePattern(const H5File& file, const DataType& dataType, const hsize_t dims[2],
+                      const Candidate& candidate, Pattern pattern, const Options& options) {
+    std::mt19937 gen(42);
+
+    // Size the buffer to one access: a row, a column, or the whole matrix
+    hsize_t accesses = 1;
+    hsize_t elements = dims[0] * dims[1];
+    if (pattern == ROW) {
+        accesses = std::min<hsize_t>(dims[0], options.samples);
+        elements = dims[1];
+    } else if (pattern == COLUMN) {
+        accesses = std::min<hsize_t>(dims[1], options.samples);
+        elements = dims[0];
+    }
+    std::vector<unsigned char> buffer(static_cast<size_t>(elements) * dataType.getSize());
+
+    double bestMs = 0.0;
+    for (int rep = 0; rep < options.repeat; ++rep) {
+        DSetAccPropList dapl;
+        if (candidate.chunked) {
+            dapl.setChunkCache(candidate.cacheSlots, candidate.cacheBytes, 0.75);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        DataSet dataset = file.openDataSet(DATA_DATASET, dapl);
+        DataSpace fileSpace = dataset.getSpace();
+        for (hsize_t i = 0; i < accesses; ++i) {
+            hsize_t offset[2] = {0, 0};
+            hsize_t count[2] = {dims[0], dims[1]};
+            if (pattern == ROW) {
+                offset[0] = std::uniform_int_distribution<hsize_t>(0, dims[0] - 1)(gen);
+                count[0] = 1;
+            } else if (pattern == COLUMN) {
+                offset[1] = std::uniform_int_distribution<hsize_t>(0, dims[1] - 1)(gen);
+                count[1] = 1;
+            }
+            fileSpace.selectHyperslab(H5S_SELECT_SET, count, offset);
+            DataSpace memSpace(2, count);
+            dataset.read(buffer.data(), dataType, memSpace, fileSpace);
+        }
+        dataset.close();
+        double ms = elapsedMs(start);
+        if (rep == 0 || ms < bestMs) {
+            bestMs = ms;
+        }
+    }
+    return bestMs * 1000.0 / static_cast<double>(accesses);
+}
+
+std::string describeChunk(const Candidate& candidate) {
+    if (!candidate.chunked) {
+        return "contiguous";
+    }
+    return std::to_string(candidate.chunk[0]) + "x" + std::to_string(candidate.chunk[1]);
+}
+
+std::string describeCache(const Candidate& candidate) {
+    if (!candidate.chunked) {
+        return "-";
+    }
+    if (candidate.cacheBytes == 0) {
+        return "off";
+    }
+    std::ostringstream out;
+    out << candidate.cacheBytes / 1024 << "K/" << candidate.cacheSlots;
+    return out.str();
+}
+
+void printReport(const std::vector<Candidate>& candidates, size_t best, const double weights[PATTERN_COUNT]) {
+    std::cout << std::left << std::setw(3) << "" << std::setw(16) << "chunk" << std::setw(16) << "cache"
+              << std::right << std::setw(12) << "write ms";
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        std::cout << std::setw(12) << (std::string(PATTERN_NAMES[p]) + " us");
+    }
+    std::cout << std::setw(12) << "score" << "\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const Candidate& c = candidates[i];
+        std::cout << std::left << std::setw(3) << (i == best ? "*" : "") << std::setw(16) << describeChunk(c)
+                  << std::setw(16) << describeCache(c) << std::right << std::setw(12) << c.writeMs;
+        for (int p = 0; p < PATTERN_COUNT; ++p) {
+            if (weights[p] > 0.0) {
+                std::cout << std::setw(12) << c.accessUs[p];
+            } else {
+                std::cout << std::setw(12) << "-";
+            }
+        }
+        std::cout << std::setw(12) << c.score << "\n";
+    }
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for " + arg);
+        }
+        std::string value = argv[++i];
+        if (arg == "--rows") {
+            options.rows = std::stoull(value);
+        } else if (arg == "--cols") {
+            options.cols = std::stoull(value);
+        } else if (arg == "--type") {
+            options.kind = parseElementKind(value);
+        } else if (arg == "--samples") {
+            options.samples = std::max(1, std::stoi(value));
+        } else if (arg == "--repeat") {
+            options.repeat = std::max(1, std::stoi(value));
+        } else if (arg == "--csv") {
+            options.csvPath = value;
+        } else if (arg == "--mix") {
+            // e.g. --mix row=0.7,col=0.3,full=0
+            std::fill(std::begin(options.weights), std::end(options.weights), 0.0);
+            std::stringstream ss(value);
+            std::string entry;
+            while (std::getline(ss, entry, ',')) {
+                size_t eq = entry.find('=');
+                std::string name = entry.substr(0, eq);
+                auto it = std::find(std::begin(PATTERN_NAMES), std::end(PATTERN_NAMES), name);
+                if (eq == std::string::npos || it == std::end(PATTERN_NAMES)) {
+                    throw std::invalid_argument("Bad --mix entry '" + entry + "'");
+                }
+                options.weights[it - std::begin(PATTERN_NAMES)] = std::stod(entry.substr(eq + 1));
+            }
+        } else {
+            throw std::invalid_argument("Unknown option " + arg);
+        }
+    }
+
+    double total = 0.0;
+    for (double w : options.weights) {
+        if (w < 0.0) {
+            throw std::invalid_argument("Access pattern weights must be non-negative");
+        }
+        total += w;
+    }
+    if (total <= 0.0) {
+        throw std::invalid_argument("At least one access pattern needs a positive weight");
+    }
+    for (double& w : options.weights) {
+        w /= total;
+    }
+    return options;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseOptions(argc, argv);
+        std::vector<std::vector<double>> csvData = readCsv(options.csvPath);
+
+        // Tune for the requested target size; default to the size of the CSV itself
+        hsize_t dims[2] = {options.rows ? options.rows : csvData.size(),
+                           options.cols ? options.cols : csvData[0].size()};
+        DataType dataType = createElementType(options.kind);
+        size_t elemSize = elementSize(options.kind);
+
+        // Synthetic readings of the target size, cycling through plausible values
+        std::vector<unsigned char> synthetic(static_cast<size_t>(dims[0] * dims[1]) * elemSize);
+        for (size_t i = 0; i < synthetic.size() / elemSize; ++i) {
+            encodeValue(20.0 + static_cast<double>(i % 6400) / 64.0, options.kind, &synthetic[i * elemSize]);
+        }
+
+        std::cout << "Tuning " << dims[0] << " x " << dims[1] << " " << elementName(options.kind) << " matrix ("
+                  << synthetic.size() << " bytes), mix:";
+        for (int p = 0; p < PATTERN_COUNT; ++p) {
+            std::cout << " " << PATTERN_NAMES[p] << "=" << std::setprecision(2) << options.weights[p];
+        }
+        std::cout << "\n\n";
+
+        std::vector<Candidate> candidates = buildCandidates(dims[0], dims[1], elemSize);
+        for (Candidate& candidate : candidates) {
+            auto start = std::chrono::steady_clock::now();
+            writeMatrix(SCRATCH_FILE_NAME, dataType, dims, candidate, synthetic);
+            candidate.writeMs = elapsedMs(start);
+
+            H5File file(SCRATCH_FILE_NAME, H5F_ACC_RDONLY);
+            candidate.score = 0.0;
+            for (int p = 0; p < PATTERN_COUNT; ++p) {
+                if (options.weights[p] > 0.0) {
+                    candidate.accessUs[p] = measurePattern(file, dataType, dims, candidate,
+                                                           static_cast<Pattern>(p), options);
+                    candidate.score += options.weights[p] * candidate.accessUs[p];
+                }
+            }
+        }
+        std::remove(SCRATCH_FILE_NAME.c_str());
+
+        size_t best = 0;
+        for (size_t i = 1; i < candidates.size(); ++i) {
+            if (candidates[i].score < candidates[best].score) {
+                best = i;
+            }
+        }
+        printReport(candidates, best, options.weights);
+
+        // Write the real data with the winning layout, clamping the chunk to the CSV's extent
+        hsize_t csvDims[2] = {csvData.size(), csvData[0].size()};
+        const Candidate& tuned = candidates[best];
+        Candidate chosen = tuned;
+        if (chosen.chunked) {
+            chosen.chunk[0] = clampDim(chosen.chunk[0], csvDims[0]);
+            chosen.chunk[1] = clampDim(chosen.chunk[1], csvDims[1]);
+            // A sized cache was sized for the tuning target; resize it for the chunks actually written
+            if (tuned.cacheBytes > DEFAULT_CACHE_BYTES && !sizeCache(chosen, csvDims[0], csvDims[1], elemSize)) {
+                chosen.cacheBytes = DEFAULT_CACHE_BYTES;
+                chosen.cacheSlots = DEFAULT_CACHE_SLOTS;
+            }
+        }
+
+        std::vector<unsigned char> flatData(static_cast<size_t>(csvDims[0] * csvDims[1]) * elemSize);
+        size_t index = 0;
+        for (const auto& row : csvData) {
+            for (double value : row) {
+                encodeValue(value, options.kind, &flatData[index++ * elemSize]);
+            }
+        }
+        writeMatrix(FILE_NAME, dataType, csvDims, chosen, flatData);
+
+        std::cout << "\nTuned for " << dims[0] << " x " << dims[1] << ": chunk " << describeChunk(tuned)
+                  << ", cache " << describeCache(tuned) << ".\n";
+        std::cout << "HDF5 file '" << FILE_NAME << "' (" << csvDims[0] << " x " << csvDims[1]
+                  << ") written with chunk " << describeChunk(chosen) << ", cache " << describeCache(chosen) << ".\n";
+
+    } catch (H5::Exception& error) {
+        std::cerr << "HDF5 Exception: " << error.getDetailMsg() << std::endl;
+        return -1;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}